@@ -1,8 +1,11 @@
-// gcc -static -O2 -Wall -Wextra -s -o myinit init-drm.c
+// gcc -static -O2 -Wall -Wextra -pthread -s -o myinit init-drm.c
 #define _GNU_SOURCE
 #include <errno.h>
 #include <fcntl.h>
+#include <pthread.h>
+#include <sched.h>
 #include <signal.h>
+#include <stdatomic.h>
 #include <stdarg.h>
 #include <stdbool.h>
 #include <stdint.h>
@@ -15,6 +18,7 @@
 #include <sys/stat.h>
 #include <sys/sysmacros.h>
 #include <sys/types.h>
+#include <time.h>
 #include <unistd.h>
 #include <dirent.h>
 
@@ -27,6 +31,8 @@
 #define DRM_MODE_DISCONNECTED 2
 #endif
 #include <drm/drm_fourcc.h>
+#include <linux/fb.h>
+#include <linux/kd.h>
 
 static int con_fd = -1;
 
@@ -66,20 +72,1006 @@ static void mount_basic(void) {
 }
 
 static uint32_t pick_crtc_id(const struct drm_mode_card_res *res,
-                             const struct drm_mode_get_encoder *enc) {
+                             const struct drm_mode_get_encoder *enc,
+                             uint32_t *index) {
     // Access arrays through the *_ptr fields
     const uint32_t *crtc_ids = (const uint32_t *)(uintptr_t)res->crtc_id_ptr;
 
-    if (enc->crtc_id) return enc->crtc_id;
-
+    for (uint32_t i = 0; enc->crtc_id && i < res->count_crtcs; i++) {
+        if (crtc_ids[i] == enc->crtc_id) { *index = i; return crtc_ids[i]; }
+    }
     for (uint32_t i = 0; i < res->count_crtcs; i++) {
-        if (enc->possible_crtcs & (1u << i)) return crtc_ids[i];
+        if (enc->possible_crtcs & (1u << i)) { *index = i; return crtc_ids[i]; }
     }
     // Fallback: first CRTC
+    *index = 0;
     return crtc_ids[0];
 }
 
-int main(void) {
+// ---- Tiled renderer ------------------------------------------------------
+//
+// The target is cut into tiles whose rows are whole cache lines (given a
+// cache-line aligned pitch) and whose footprint fits in L1. Tiles are handed
+// out over a small work-stealing pool, one worker per online CPU.
+
+struct rect { int x0, y0, x1, y1; };   // half-open [x0,x1) x [y0,y1)
+
+// Filled ring: pixels with rin2 <= d^2 <= rout2 around (cx,cy), limited to
+// clip. A disc is a ring with rin2 == 0. Later prims paint over earlier ones.
+struct prim {
+    int cx, cy;
+    int rin2, rout2;
+    struct rect clip;
+    uint32_t color;
+};
+
+#define SCENE_MAX_PRIMS 16
+
+struct scene {
+    uint32_t bg;
+    int nprims;
+    struct prim prims[SCENE_MAX_PRIMS];
+};
+
+// The renderer only draws XRGB8888; the splash decoder also handles
+// XBGR8888 and RGB565.
+struct target {
+    uint8_t *map;
+    uint32_t width, height, pitch;
+    uint32_t format;            // DRM_FORMAT_*
+};
+
+static inline struct rect rect_intersect(struct rect a, struct rect b) {
+    struct rect r = {
+        a.x0 > b.x0 ? a.x0 : b.x0, a.y0 > b.y0 ? a.y0 : b.y0,
+        a.x1 < b.x1 ? a.x1 : b.x1, a.y1 < b.y1 ? a.y1 : b.y1,
+    };
+    return r;
+}
+
+static inline bool rect_empty(struct rect r) {
+    return r.x0 >= r.x1 || r.y0 >= r.y1;
+}
+
+static struct prim *scene_ring(struct scene *s, int cx, int cy,
+                               int rin, int rout, uint32_t color) {
+    if (s->nprims == SCENE_MAX_PRIMS) fatal("scene: too many primitives");
+    struct prim *p = &s->prims[s->nprims++];
+    p->cx = cx; p->cy = cy;
+    p->rin2  = rin > 0 ? rin * rin : 0;
+    p->rout2 = rout * rout;
+    p->clip  = (struct rect){ cx - rout, cy - rout, cx + rout + 1, cy + rout + 1 };
+    p->color = color;
+    return p;
+}
+
+static struct prim *scene_disc(struct scene *s, int cx, int cy, int r, uint32_t color) {
+    return scene_ring(s, cx, cy, 0, r, color);
+}
+
+static void scene_smiley(struct scene *s, uint32_t width, uint32_t height) {
+    const uint32_t yellow = 0x00FFFF00;
+    const uint32_t eye    = 0x00000000;
+    const uint32_t mouth  = 0x00000000;
+
+    int cx = width / 2, cy = height / 2;
+    int r  = (height < width ? height : width) / 6;
+    struct rect face = { cx - r, cy - r, cx + r + 1, cy + r + 1 };
+
+    s->bg = 0x00000000;
+    s->nprims = 0;
+    scene_disc(s, cx, cy, r, yellow);
+
+    int ex = r/2, ey = -r/3, er = r/10;
+    scene_disc(s, cx - ex, cy - ey, er, eye);
+    scene_disc(s, cx + ex, cy - ey, er, eye);
+
+    // smile: lower half of a thin ring, kept inside the face box
+    int mr = r/2;
+    struct prim *m = scene_ring(s, cx, cy + mr/3, mr - 2, mr + 2, mouth);
+    face.y0 = cy + 1;
+    m->clip = rect_intersect(m->clip, face);
+}
+
+struct tile_grid {
+    int tw, th, cols, rows;
+};
+
+static struct tile_grid tile_grid_for(const struct target *t) {
+    long line = sysconf(_SC_LEVEL1_DCACHE_LINESIZE);
+    long l1   = sysconf(_SC_LEVEL1_DCACHE_SIZE);
+    if (line <= 0) line = 64;
+    if (l1 <= 0)   l1 = 32 * 1024;
+
+    // 4 cache lines per tile row; tile edges only land on line boundaries
+    // when the pitch itself is line aligned, otherwise fall back to one line.
+    int row_bytes = (t->pitch % line == 0) ? 4 * line : line;
+    struct tile_grid g;
+    g.tw = row_bytes / 4;
+    g.th = (l1 / 2) / row_bytes;          // leave half of L1 for the rest
+    if (g.th < 8)   g.th = 8;
+    if (g.th > 256) g.th = 256;
+    g.cols = (t->width  + g.tw - 1) / g.tw;
+    g.rows = (t->height + g.th - 1) / g.th;
+    return g;
+}
+
+static inline struct rect tile_rect(const struct tile_grid *g, const struct target *t,
+                                    uint32_t idx) {
+    int x0 = (idx % g->cols) * g->tw, y0 = (idx / g->cols) * g->th;
+    struct rect r = { x0, y0, x0 + g->tw, y0 + g->th };
+    if (r.x1 > (int)t->width)  r.x1 = t->width;
+    if (r.y1 > (int)t->height) r.y1 = t->height;
+    return r;
+}
+
+static bool tile_has_prims(const struct scene *s, struct rect tr) {
+    for (int i = 0; i < s->nprims; i++)
+        if (!rect_empty(rect_intersect(tr, s->prims[i].clip))) return true;
+    return false;
+}
+
+struct render_job {
+    const struct scene *scene;
+    const struct target *target;
+    struct tile_grid grid;
+    bool clear;                 // false: only touch tiles under primitives
+};
+
+static void render_tile(const struct render_job *job, uint32_t idx) {
+    const struct target *t = job->target;
+    const struct scene *s  = job->scene;
+    struct rect tr = tile_rect(&job->grid, t, idx);
+
+    if (job->clear) {
+        for (int y = tr.y0; y < tr.y1; y++) {
+            uint32_t *row = (uint32_t *)(t->map + (size_t)y * t->pitch);
+            for (int x = tr.x0; x < tr.x1; x++) row[x] = s->bg;
+        }
+    }
+
+    for (int i = 0; i < s->nprims; i++) {
+        const struct prim *p = &s->prims[i];
+        struct rect c = rect_intersect(tr, p->clip);
+        if (rect_empty(c)) continue;
+
+        for (int y = c.y0; y < c.y1; y++) {
+            uint32_t *row = (uint32_t *)(t->map + (size_t)y * t->pitch);
+            int dy = y - p->cy, dy2 = dy * dy;
+            for (int x = c.x0; x < c.x1; x++) {
+                int dx = x - p->cx, d2 = dx * dx + dy2;
+                if (d2 >= p->rin2 && d2 <= p->rout2) row[x] = p->color;
+            }
+        }
+    }
+}
+
+// Each worker owns a contiguous slice of the tile list. Owners and thieves
+// both claim tiles with fetch_add on the slice cursor, so every tile is
+// rendered exactly once without locks.
+struct tile_queue {
+    _Alignas(64) atomic_uint next;
+    uint32_t end;
+};
+
+struct render_pool {
+    int nworkers;
+    pthread_t *threads;
+    struct tile_queue *queues;
+    pthread_barrier_t start, done;
+    pthread_mutex_t gate;       // held until the barriers match the started workers
+    bool quit;
+    const struct render_job *job;
+    uint32_t *tiles;
+    uint32_t max_tiles;
+};
+
+struct worker_arg {
+    struct render_pool *pool;
+    int id;
+};
+
+static void pool_drain(struct render_pool *pool, int id) {
+    for (int k = 0; k < pool->nworkers; k++) {
+        struct tile_queue *q = &pool->queues[(id + k) % pool->nworkers];
+        for (;;) {
+            uint32_t i = atomic_fetch_add_explicit(&q->next, 1, memory_order_relaxed);
+            if (i >= q->end) break;
+            render_tile(pool->job, pool->tiles[i]);
+        }
+    }
+}
+
+static void *pool_worker(void *arg) {
+    struct worker_arg *wa = arg;
+    struct render_pool *pool = wa->pool;
+    int id = wa->id;
+    free(wa);
+
+    pthread_mutex_lock(&pool->gate);
+    pthread_mutex_unlock(&pool->gate);
+
+    for (;;) {
+        pthread_barrier_wait(&pool->start);
+        if (pool->quit) break;
+        pool_drain(pool, id);
+        pthread_barrier_wait(&pool->done);
+    }
+    return NULL;
+}
+
+static int online_cpus(int *cpus, int max) {
+    cpu_set_t set;
+    int n = 0;
+    if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+        for (int c = 0; c < CPU_SETSIZE && n < max; c++)
+            if (CPU_ISSET(c, &set)) cpus[n++] = c;
+    }
+    if (n == 0) cpus[n++] = 0;
+    return n;
+}
+
+// nworkers <= 0 means one worker per online CPU. The calling thread is
+// worker 0 and is left unpinned so processes it spawns later keep the full
+// CPU mask; workers 1..n-1 are pinned to their own cores. If a worker can't
+// be started the pool runs with the ones that did, down to just the caller.
+static struct render_pool *pool_create(int nworkers, uint32_t max_tiles) {
+    int cpus[CPU_SETSIZE];
+    int ncpus = online_cpus(cpus, CPU_SETSIZE);
+    if (nworkers <= 0) nworkers = ncpus;
+
+    struct render_pool *pool = calloc(1, sizeof(*pool));
+    if (!pool) fatal("pool: malloc failed");
+    pool->nworkers  = nworkers;
+    pool->max_tiles = max_tiles;
+    pool->threads   = calloc(nworkers, sizeof(*pool->threads));
+    pool->queues    = aligned_alloc(64, nworkers * sizeof(*pool->queues));
+    pool->tiles     = malloc(max_tiles * sizeof(*pool->tiles));
+    if (!pool->threads || !pool->queues || !pool->tiles) fatal("pool: malloc failed");
+    for (int i = 0; i < nworkers; i++) {
+        atomic_init(&pool->queues[i].next, 0);
+        pool->queues[i].end = 0;
+    }
+
+    pthread_mutex_init(&pool->gate, NULL);
+    pthread_mutex_lock(&pool->gate);
+
+    int started = 1;
+    for (int i = 1; i < nworkers; i++) {
+        struct worker_arg *wa = malloc(sizeof(*wa));
+        if (!wa) break;
+        wa->pool = pool; wa->id = i;
+
+        // pin before the thread first runs, so it never starts on a foreign core
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpus[i % ncpus], &set);
+        pthread_attr_t attr;
+        pthread_attr_init(&attr);
+        int err = pthread_attr_setaffinity_np(&attr, sizeof(set), &set);
+        if (err != 0)
+            logc("init: pool: pinning worker %d to cpu %d failed: %s\n",
+                 i, cpus[i % ncpus], strerror(err));
+        err = pthread_create(&pool->threads[i], err == 0 ? &attr : NULL, pool_worker, wa);
+        pthread_attr_destroy(&attr);
+        if (err != 0) {
+            logc("init: pool: starting worker %d failed: %s, using %d\n",
+                 i, strerror(err), started);
+            free(wa);
+            break;
+        }
+        started++;
+    }
+
+    pool->nworkers = started;
+    pthread_barrier_init(&pool->start, NULL, started);
+    pthread_barrier_init(&pool->done,  NULL, started);
+    pthread_mutex_unlock(&pool->gate);
+    return pool;
+}
+
+static void pool_destroy(struct render_pool *pool) {
+    pool->quit = true;
+    pthread_barrier_wait(&pool->start);
+    for (int i = 1; i < pool->nworkers; i++) pthread_join(pool->threads[i], NULL);
+    pthread_barrier_destroy(&pool->start);
+    pthread_barrier_destroy(&pool->done);
+    pthread_mutex_destroy(&pool->gate);
+    free(pool->tiles); free(pool->queues); free(pool->threads); free(pool);
+}
+
+// Renders one frame; returns the number of tiles that were touched.
+static uint32_t pool_render(struct render_pool *pool, const struct render_job *job) {
+    const struct tile_grid *g = &job->grid;
+    uint32_t total = g->cols * g->rows, n = 0;
+    if (total > pool->max_tiles) fatal("pool: %u tiles > %u", total, pool->max_tiles);
+
+    for (uint32_t i = 0; i < total; i++) {
+        if (job->clear || tile_has_prims(job->scene, tile_rect(g, job->target, i)))
+            pool->tiles[n++] = i;
+    }
+
+    uint32_t per = n / pool->nworkers, extra = n % pool->nworkers, at = 0;
+    for (int w = 0; w < pool->nworkers; w++) {
+        uint32_t len = per + ((uint32_t)w < extra);
+        atomic_store_explicit(&pool->queues[w].next, at, memory_order_relaxed);
+        pool->queues[w].end = at + len;
+        at += len;
+    }
+    pool->job = job;
+
+    pthread_barrier_wait(&pool->start);
+    pool_drain(pool, 0);
+    pthread_barrier_wait(&pool->done);
+    return n;
+}
+
+static double now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e3 + ts.tv_nsec / 1e6;
+}
+
+// Headless backend: render the boot scene into an anonymous 4K buffer with
+// 1..N workers and print per-frame times. Run as `myinit --bench [N]`.
+static int run_bench(int max_workers) {
+    struct target t = { .width = 3840, .height = 2160, .format = DRM_FORMAT_XRGB8888 };
+    t.pitch = (t.width * 4 + 63) & ~63u;
+    t.map = mmap(NULL, (size_t)t.pitch * t.height, PROT_READ | PROT_WRITE,
+                 MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (t.map == MAP_FAILED) { perror("mmap"); return 1; }
+
+    int cpus[CPU_SETSIZE];
+    if (max_workers <= 0) max_workers = online_cpus(cpus, CPU_SETSIZE);
+
+    struct scene s;
+    scene_smiley(&s, t.width, t.height);
+    struct render_job job = { .scene = &s, .target = &t, .grid = tile_grid_for(&t) };
+    uint32_t ntiles = job.grid.cols * job.grid.rows;
+
+    printf("headless: %ux%u pitch=%u tile=%dx%d (%u tiles), up to %d workers\n",
+           t.width, t.height, t.pitch, job.grid.tw, job.grid.th, ntiles, max_workers);
+
+    const int frames = 50;
+    double base_full = 0, base_damage = 0;
+    for (int n = 1; n <= max_workers; n++) {
+        struct render_pool *pool = pool_create(n, ntiles);
+        int started = pool->nworkers;           // fewer if threads ran out
+        uint32_t touched = 0;
+        double ms[2];
+
+        for (int pass = 0; pass < 2; pass++) {
+            job.clear = pass == 0;
+            pool_render(pool, &job);                    // warm up
+            double t0 = now_ms();
+            for (int f = 0; f < frames; f++) touched = pool_render(pool, &job);
+            ms[pass] = (now_ms() - t0) / frames;
+        }
+        pool_destroy(pool);
+
+        if (n == 1) { base_full = ms[0]; base_damage = ms[1]; }
+        printf("workers=%2d  full %7.3f ms (x%.2f)  prims-only %7.3f ms (x%.2f, %u tiles)\n",
+               started, ms[0], base_full / ms[0], ms[1], base_damage / ms[1], touched);
+    }
+    munmap(t.map, (size_t)t.pitch * t.height);
+    return 0;
+}
+
+// ---- Boot splash ---------------------------------------------------------
+//
+// Splash images are QOI files (https://qoiformat.org). The file is mmapped
+// and decoded pixel by pixel straight into the scanout memory, so the only
+// state is QOI's 64-entry colour index. Images are never scaled: ship one
+// prescaled file per resolution as <dir>/splash-<W>x<H>.qoi, with
+// <dir>/splash.qoi as a fallback that is centred (or cropped). <dir> is
+// /splash unless the kernel command line has splash=<dir>.
+
+#define QOI_HEADER_SIZE 14
+#define QOI_PADDING     8      // 7x 0x00, 1x 0x01
+
+#define QOI_OP_INDEX 0x00
+#define QOI_OP_DIFF  0x40
+#define QOI_OP_LUMA  0x80
+#define QOI_OP_RUN   0xc0
+#define QOI_OP_RGB   0xfe
+#define QOI_OP_RGBA  0xff
+#define QOI_MASK_2   0xc0
+
+struct rgba { uint8_t r, g, b, a; };
+
+static inline uint32_t be32(const uint8_t *p) {
+    return (uint32_t)p[0] << 24 | (uint32_t)p[1] << 16 | (uint32_t)p[2] << 8 | p[3];
+}
+
+static inline void store_px(uint8_t *dst, uint32_t format, struct rgba c) {
+    // composite over black
+    if (c.a != 255) {
+        c.r = c.r * c.a / 255; c.g = c.g * c.a / 255; c.b = c.b * c.a / 255;
+    }
+    if (format == DRM_FORMAT_RGB565)
+        *(uint16_t *)dst = (c.r >> 3) << 11 | (c.g >> 2) << 5 | c.b >> 3;
+    else if (format == DRM_FORMAT_XBGR8888)
+        *(uint32_t *)dst = (uint32_t)c.b << 16 | (uint32_t)c.g << 8 | c.r;
+    else
+        *(uint32_t *)dst = (uint32_t)c.r << 16 | (uint32_t)c.g << 8 | c.b;
+}
+
+// Black in every supported format is all-zero bytes.
+static void clear_rows(const struct target *t, int y0, int y1, unsigned bpp) {
+    for (int y = y0 < 0 ? 0 : y0; y < y1 && y < (int)t->height; y++)
+        memset(t->map + (size_t)y * t->pitch, 0, (size_t)t->width * bpp);
+}
+
+static bool qoi_header(const uint8_t *p, size_t len, uint32_t *w, uint32_t *h) {
+    if (len < QOI_HEADER_SIZE + QOI_PADDING || memcmp(p, "qoif", 4) != 0) return false;
+    *w = be32(p + 4);
+    *h = be32(p + 8);
+    return *w && *h && *w <= 16384 && *h <= 16384;
+}
+
+// Walks the chunk stream without decoding and checks that it covers every
+// pixel, so a truncated file is rejected before anything hits the screen.
+static bool qoi_check(const uint8_t *p, size_t len) {
+    uint32_t w, h;
+    if (!qoi_header(p, len, &w, &h)) return false;
+
+    const uint8_t *in = p + QOI_HEADER_SIZE, *end = p + len - QOI_PADDING;
+    uint64_t want = (uint64_t)w * h, got = 0;
+    while (got < want) {
+        if (in >= end) return false;
+        uint8_t b1 = *in;
+        if (b1 == QOI_OP_RGB)                            { in += 4; got++; }
+        else if (b1 == QOI_OP_RGBA)                      { in += 5; got++; }
+        else if ((b1 & QOI_MASK_2) == QOI_OP_LUMA)       { in += 2; got++; }
+        else if ((b1 & QOI_MASK_2) == QOI_OP_RUN)        { in += 1; got += (b1 & 0x3f) + 1; }
+        else                                             { in += 1; got++; }
+        if (in > end) return false;
+    }
+    return true;
+}
+
+// Decodes a QOI image into t, centred. With clear set, everything around
+// the image is filled with black as the rows stream past. Returns false on
+// a malformed file, leaving a partial image behind; run qoi_check() first.
+static bool qoi_draw(const struct target *t, const uint8_t *p, size_t len, bool clear) {
+    uint32_t w, h;
+    if (!qoi_header(p, len, &w, &h)) return false;
+
+    const uint8_t *in = p + QOI_HEADER_SIZE, *end = p + len - QOI_PADDING;
+    unsigned bpp = t->format == DRM_FORMAT_RGB565 ? 2 : 4;
+    int ox = ((int)t->width - (int)w) / 2, oy = ((int)t->height - (int)h) / 2;
+
+    // visible span of every image row, in image coordinates
+    uint32_t vx0 = ox < 0 ? -ox : 0;
+    uint32_t vx1 = w;
+    if ((int)w + ox > (int)t->width) vx1 = t->width - ox;
+
+    struct rgba index[64] = {0};
+    struct rgba px = { 0, 0, 0, 255 };
+    int run = 0;
+
+    if (clear) clear_rows(t, 0, oy, bpp);
+
+    for (uint32_t y = 0; y < h; y++) {
+        int sy = oy + (int)y;
+        bool visible = sy >= 0 && sy < (int)t->height;
+        uint8_t *row = visible ? t->map + (size_t)sy * t->pitch + (ptrdiff_t)ox * bpp : NULL;
+        if (row && clear) {
+            uint8_t *line = t->map + (size_t)sy * t->pitch;
+            if (ox > 0) memset(line, 0, (size_t)ox * bpp);
+            if (ox + (int)w < (int)t->width)
+                memset(line + (size_t)(ox + w) * bpp, 0, (size_t)(t->width - ox - w) * bpp);
+        }
+
+        for (uint32_t x = 0; x < w; x++) {
+            if (run > 0) {
+                run--;
+            } else {
+                if (in >= end) return false;
+                uint8_t b1 = *in++;
+                if (b1 == QOI_OP_RGB) {
+                    if (end - in < 3) return false;
+                    px.r = in[0]; px.g = in[1]; px.b = in[2]; in += 3;
+                } else if (b1 == QOI_OP_RGBA) {
+                    if (end - in < 4) return false;
+                    px.r = in[0]; px.g = in[1]; px.b = in[2]; px.a = in[3]; in += 4;
+                } else if ((b1 & QOI_MASK_2) == QOI_OP_INDEX) {
+                    px = index[b1];
+                } else if ((b1 & QOI_MASK_2) == QOI_OP_DIFF) {
+                    px.r += ((b1 >> 4) & 3) - 2;
+                    px.g += ((b1 >> 2) & 3) - 2;
+                    px.b += ( b1       & 3) - 2;
+                } else if ((b1 & QOI_MASK_2) == QOI_OP_LUMA) {
+                    if (in >= end) return false;
+                    uint8_t b2 = *in++;
+                    int vg = (b1 & 0x3f) - 32;
+                    px.r += vg - 8 + ((b2 >> 4) & 0x0f);
+                    px.g += vg;
+                    px.b += vg - 8 + (b2 & 0x0f);
+                } else {
+                    run = b1 & 0x3f;
+                }
+                index[(px.r * 3 + px.g * 5 + px.b * 7 + px.a * 11) % 64] = px;
+            }
+            if (row && x >= vx0 && x < vx1) store_px(row + (size_t)x * bpp, t->format, px);
+        }
+    }
+    if (clear) clear_rows(t, oy + (int)h, t->height, bpp);
+    return true;
+}
+
+// Tries the per-resolution splash, then the generic one. Returns true once
+// an image has been drawn into t.
+static bool splash_show(const struct target *t, bool clear) {
+    const char *dir = getenv("splash");
+    if (!dir || !*dir) dir = "/splash";
+
+    char paths[2][256];
+    snprintf(paths[0], sizeof(paths[0]), "%s/splash-%ux%u.qoi", dir, t->width, t->height);
+    snprintf(paths[1], sizeof(paths[1]), "%s/splash.qoi", dir);
+
+    for (int i = 0; i < 2; i++) {
+        int fd = open(paths[i], O_RDONLY | O_CLOEXEC);
+        if (fd < 0) continue;
+
+        struct stat st;
+        if (fstat(fd, &st) < 0 || st.st_size == 0) { close(fd); continue; }
+        uint8_t *img = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (img == MAP_FAILED) continue;
+        madvise(img, st.st_size, MADV_SEQUENTIAL);
+
+        if (!qoi_check(img, st.st_size)) {
+            logc("init: splash %s is not a valid QOI image\n", paths[i]);
+            munmap(img, st.st_size);
+            continue;
+        }
+        bool ok = qoi_draw(t, img, st.st_size, clear);
+        munmap(img, st.st_size);
+        if (ok) {
+            logc("init: splash %s\n", paths[i]);
+            return true;
+        }
+        // can't happen after qoi_check(), but never leave a half image
+        // under a fallback that assumes a black buffer
+        logc("init: splash %s failed mid-decode\n", paths[i]);
+        clear_rows(t, 0, t->height, t->format == DRM_FORMAT_RGB565 ? 2 : 4);
+    }
+    return false;
+}
+
+// Shows the splash (or the smiley) on the scanout buffer behind t. With
+// clear=false t must already hold the black background (fresh dumb
+// buffers are zero filled) and only tiles under the smiley are rendered.
+static void paint_boot_screen(const struct target *t, bool clear) {
+    if (splash_show(t, clear)) return;
+
+    if (t->format != DRM_FORMAT_XRGB8888) {
+        logc("init: no splash and no renderer for this pixel format\n");
+        return;
+    }
+    struct scene scene;
+    scene_smiley(&scene, t->width, t->height);
+
+    struct render_job job = { .scene = &scene, .target = t, .clear = clear };
+    job.grid = tile_grid_for(t);
+    struct render_pool *pool = pool_create(0, job.grid.cols * job.grid.rows);
+    uint32_t touched = pool_render(pool, &job);
+    logc("init: smiley rendered by %d workers, %u/%d tiles of %dx%d\n",
+         pool->nworkers, touched, job.grid.cols * job.grid.rows, job.grid.tw, job.grid.th);
+    pool_destroy(pool);
+}
+
+// Maps the fbdev channel layout to a DRM fourcc, 0 if we can't write it.
+static uint32_t fbdev_format(const struct fb_var_screeninfo *v) {
+    const struct fb_bitfield *r = &v->red, *g = &v->green, *b = &v->blue;
+    if (v->bits_per_pixel == 32 && r->length == 8 && g->length == 8 && b->length == 8 &&
+        g->offset == 8) {
+        if (r->offset == 16 && b->offset == 0) return DRM_FORMAT_XRGB8888;
+        if (r->offset == 0 && b->offset == 16) return DRM_FORMAT_XBGR8888;
+    }
+    if (v->bits_per_pixel == 16 && r->offset == 11 && r->length == 5 &&
+        g->offset == 5 && g->length == 6 && b->offset == 0 && b->length == 5)
+        return DRM_FORMAT_RGB565;
+    return 0;
+}
+
+// Fallback when there is no KMS device: paint straight into /dev/fb0.
+__attribute__((noreturn))
+static void run_fbdev(void) {
+    int fb = open("/dev/fb0", O_RDWR | O_CLOEXEC);
+    if (fb < 0) fatal("no /dev/dri/card0 and open /dev/fb0 failed: %m");
+
+    struct fb_var_screeninfo v;
+    struct fb_fix_screeninfo f;
+    if (ioctl(fb, FBIOGET_VSCREENINFO, &v) < 0) fatal("FBIOGET_VSCREENINFO failed: %m");
+    if (ioctl(fb, FBIOGET_FSCREENINFO, &f) < 0) fatal("FBIOGET_FSCREENINFO failed: %m");
+    uint32_t format = fbdev_format(&v);
+    if (!format)
+        fatal("fbdev: unsupported %u bpp layout r%u:%u g%u:%u b%u:%u", v.bits_per_pixel,
+              v.red.offset, v.red.length, v.green.offset, v.green.length,
+              v.blue.offset, v.blue.length);
+
+    uint8_t *base = mmap(NULL, f.smem_len, PROT_READ | PROT_WRITE, MAP_SHARED, fb, 0);
+    if (base == MAP_FAILED) fatal("mmap fb failed: %m");
+
+    struct target t = {
+        .map    = base + (size_t)v.yoffset * f.line_length + (size_t)v.xoffset * (v.bits_per_pixel / 8),
+        .width  = v.xres, .height = v.yres, .pitch = f.line_length,
+        .format = format,
+    };
+
+    // stop fbcon from drawing text and the cursor over the splash
+    if (access("/dev/tty0", W_OK) != 0) mknod("/dev/tty0", S_IFCHR | 0600, makedev(4, 0));
+    int tty = open("/dev/tty0", O_RDWR | O_NOCTTY | O_CLOEXEC);
+    if (tty < 0) tty = open("/dev/console", O_RDWR | O_NOCTTY | O_CLOEXEC);
+    if (tty < 0 || ioctl(tty, KDSETMODE, KD_GRAPHICS) < 0)
+        logc("init: KDSETMODE KD_GRAPHICS failed: %m, console may draw over the splash\n");
+
+    double t0 = now_ms();
+    paint_boot_screen(&t, true);
+    logc("init: fbdev %ux%u@%u line=%u, splash visible after %.2f ms\n",
+         v.xres, v.yres, v.bits_per_pixel, f.line_length, now_ms() - t0);
+
+    signal(SIGINT, SIG_IGN);
+    for (;;) pause();
+}
+
+// ---- Progress indicator --------------------------------------------------
+//
+// A small marker that moves along a track below the splash. When the CRTC
+// has a free cursor (or overlay) plane the marker lives in its own small
+// dumb buffer and an update only moves the plane; otherwise it is
+// composited into the primary buffer with a save-under copy. Either way an
+// update costs O(marker), not O(screen).
+//
+// Legacy SETPLANE on an overlay is a blocking commit that waits a full
+// frame, so overlays are moved with a nonblocking atomic commit instead.
+// Cursor planes take the legacy cursor fast path and don't need that.
+
+#ifndef DRM_PLANE_TYPE_OVERLAY
+#define DRM_PLANE_TYPE_OVERLAY 0
+#define DRM_PLANE_TYPE_PRIMARY 1
+#define DRM_PLANE_TYPE_CURSOR  2
+#endif
+
+#define MARKER_SIZE 64          // drawn marker; plane buffers may be larger
+
+struct indicator {
+    int drm;
+    uint32_t crtc_id;
+    const struct target *screen;
+    uint32_t screen_fb;
+
+    struct target sprite;       // ARGB8888, alpha 0 = transparent
+    uint32_t sprite_handle, sprite_fb;
+    int marker;                 // marker size inside the sprite
+    uint32_t plane_id;          // 0: software compositing
+    int plane_type;
+    uint32_t prop_crtc_x, prop_crtc_y;  // atomic moves; 0 = use SETPLANE
+
+    struct rect track;          // marker x runs over [x0, x1 - marker]
+    struct rect at;             // current position, empty before first update
+    uint32_t *under;            // save-under for software compositing
+    bool off;                   // gave up; updates are ignored
+};
+
+// Looks up a plane property by name; returns its value, or -1 if absent.
+static int64_t plane_prop(int drm, uint32_t plane_id, const char *name, uint32_t *prop_id) {
+    struct drm_mode_obj_get_properties op = { .obj_id = plane_id, .obj_type = DRM_MODE_OBJECT_PLANE };
+    if (ioctl(drm, DRM_IOCTL_MODE_OBJ_GETPROPERTIES, &op) < 0 || !op.count_props) return -1;
+
+    uint32_t *ids = malloc(op.count_props * sizeof(*ids));
+    uint64_t *vals = malloc(op.count_props * sizeof(*vals));
+    int64_t value = -1;
+    if (!ids || !vals) goto out;
+    op.props_ptr = (uintptr_t)ids;
+    op.prop_values_ptr = (uintptr_t)vals;
+    if (ioctl(drm, DRM_IOCTL_MODE_OBJ_GETPROPERTIES, &op) < 0) goto out;
+
+    for (uint32_t i = 0; i < op.count_props; i++) {
+        struct drm_mode_get_property prop = { .prop_id = ids[i] };
+        if (ioctl(drm, DRM_IOCTL_MODE_GETPROPERTY, &prop) < 0) continue;
+        if (strcmp(prop.name, name) == 0) {
+            value = (int64_t)vals[i];
+            if (prop_id) *prop_id = ids[i];
+            break;
+        }
+    }
+out:
+    free(ids); free(vals);
+    return value;
+}
+
+static bool plane_has_format(int drm, struct drm_mode_get_plane *pl, uint32_t format) {
+    if (!pl->count_format_types) return false;
+    uint32_t *fmts = malloc(pl->count_format_types * sizeof(*fmts));
+    if (!fmts) return false;
+    struct drm_mode_get_plane q = { .plane_id = pl->plane_id,
+                                    .count_format_types = pl->count_format_types,
+                                    .format_type_ptr = (uintptr_t)fmts };
+    bool found = false;
+    if (ioctl(drm, DRM_IOCTL_MODE_GETPLANE, &q) == 0) {
+        for (uint32_t i = 0; i < q.count_format_types && !found; i++)
+            found = fmts[i] == format;
+    }
+    free(fmts);
+    return found;
+}
+
+// Picks an idle ARGB8888 plane usable on the CRTC at crtc_index, preferring
+// the cursor plane over overlays. Returns 0 if there is none.
+static uint32_t find_spare_plane(int drm, uint32_t crtc_index, int *type_out) {
+    struct drm_set_client_cap cap = { .capability = DRM_CLIENT_CAP_UNIVERSAL_PLANES, .value = 1 };
+    if (ioctl(drm, DRM_IOCTL_SET_CLIENT_CAP, &cap) < 0) return 0;
+
+    struct drm_mode_get_plane_res pres = {0};
+    if (ioctl(drm, DRM_IOCTL_MODE_GETPLANERESOURCES, &pres) < 0 || !pres.count_planes) return 0;
+    uint32_t *ids = malloc(pres.count_planes * sizeof(*ids));
+    if (!ids) return 0;
+    pres.plane_id_ptr = (uintptr_t)ids;
+    if (ioctl(drm, DRM_IOCTL_MODE_GETPLANERESOURCES, &pres) < 0) { free(ids); return 0; }
+
+    uint32_t best = 0;
+    int best_type = -1;
+    for (uint32_t i = 0; i < pres.count_planes; i++) {
+        struct drm_mode_get_plane pl = { .plane_id = ids[i] };
+        if (ioctl(drm, DRM_IOCTL_MODE_GETPLANE, &pl) < 0) continue;
+        if (!(pl.possible_crtcs & (1u << crtc_index)) || pl.fb_id) continue;
+
+        int type = (int)plane_prop(drm, pl.plane_id, "type", NULL);
+        if (type != DRM_PLANE_TYPE_OVERLAY && type != DRM_PLANE_TYPE_CURSOR) continue;
+        if (best && best_type == DRM_PLANE_TYPE_CURSOR) continue;
+        if (!plane_has_format(drm, &pl, DRM_FORMAT_ARGB8888)) continue;
+
+        best = pl.plane_id;
+        best_type = type;
+    }
+    free(ids);
+    *type_out = best_type;
+    return best;
+}
+
+static uint64_t drm_cap(int drm, uint64_t capability, uint64_t fallback) {
+    struct drm_get_cap cap = { .capability = capability };
+    if (ioctl(drm, DRM_IOCTL_GET_CAP, &cap) < 0 || !cap.value) return fallback;
+    return cap.value;
+}
+
+static void render_serial(const struct render_job *job) {
+    for (uint32_t i = 0; i < (uint32_t)(job->grid.cols * job->grid.rows); i++)
+        render_tile(job, i);
+}
+
+static void indicator_paint_sprite(struct indicator *ind) {
+    struct scene s = { .bg = 0x00000000 };
+    int c = ind->marker / 2;
+    scene_disc(&s, c, c, c - 4, 0xFFFFFFFF);
+    scene_disc(&s, c, c, c / 2, 0xFF3070FF);
+    struct render_job job = { .scene = &s, .target = &ind->sprite, .clear = true };
+    job.grid = tile_grid_for(&ind->sprite);
+    render_serial(&job);
+}
+
+// Drops the plane (disabling it and freeing its fb) and composites from now
+// on. Returns false, turning the indicator off, if there's no memory for it.
+static bool indicator_to_software(struct indicator *ind) {
+    if (ind->plane_id) {
+        struct drm_mode_set_plane off = { .plane_id = ind->plane_id };  // fb_id 0 disables
+        if (ioctl(ind->drm, DRM_IOCTL_MODE_SETPLANE, &off) < 0)
+            logc("init: disabling plane %u failed: %m\n", ind->plane_id);
+    }
+    if (ind->sprite_fb) {
+        uint32_t fb_id = ind->sprite_fb;
+        ioctl(ind->drm, DRM_IOCTL_MODE_RMFB, &fb_id);
+    }
+    ind->plane_id = 0;
+    ind->sprite_fb = 0;
+    ind->at = (struct rect){0};
+    if (!ind->under) {
+        ind->under = malloc((size_t)ind->sprite.width * ind->sprite.height * sizeof(*ind->under));
+        if (!ind->under) {
+            logc("init: indicator: malloc failed, no progress marker\n");
+            ind->off = true;
+            return false;
+        }
+    }
+    return true;
+}
+
+// Creates the plane's own sw x sh dumb buffer and fb. On failure it logs,
+// releases whatever it made and returns false.
+static bool indicator_plane_buffer(struct indicator *ind, uint32_t sw, uint32_t sh) {
+    int drm = ind->drm;
+    struct drm_mode_create_dumb creq = { .width = sw, .height = sh, .bpp = 32 };
+    if (ioctl(drm, DRM_IOCTL_MODE_CREATE_DUMB, &creq) < 0) {
+        logc("init: indicator: CREATE_DUMB %ux%u failed: %m\n", sw, sh);
+        return false;
+    }
+    struct drm_mode_destroy_dumb dreq = { .handle = creq.handle };
+
+    struct drm_mode_map_dumb mreq = { .handle = creq.handle };
+    uint8_t *map = MAP_FAILED;
+    if (ioctl(drm, DRM_IOCTL_MODE_MAP_DUMB, &mreq) == 0)
+        map = mmap(NULL, creq.size, PROT_READ | PROT_WRITE, MAP_SHARED, drm, mreq.offset);
+    if (map == MAP_FAILED) {
+        logc("init: indicator: mapping %ux%u buffer failed: %m\n", sw, sh);
+        ioctl(drm, DRM_IOCTL_MODE_DESTROY_DUMB, &dreq);
+        return false;
+    }
+
+    struct drm_mode_fb_cmd2 fb = {0};
+    fb.width  = creq.width;
+    fb.height = creq.height;
+    fb.pixel_format = DRM_FORMAT_ARGB8888;
+    fb.pitches[0] = creq.pitch;
+    fb.handles[0] = creq.handle;
+    if (ioctl(drm, DRM_IOCTL_MODE_ADDFB2, &fb) < 0) {
+        logc("init: indicator: ADDFB2 failed: %m\n");
+        munmap(map, creq.size);
+        ioctl(drm, DRM_IOCTL_MODE_DESTROY_DUMB, &dreq);
+        return false;
+    }
+
+    ind->sprite = (struct target){ map, creq.width, creq.height, creq.pitch, DRM_FORMAT_ARGB8888 };
+    ind->sprite_handle = creq.handle;
+    ind->sprite_fb = fb.fb_id;
+    ind->marker = MARKER_SIZE;
+    if ((int)sw < ind->marker) ind->marker = sw;
+    if ((int)sh < ind->marker) ind->marker = sh;
+    indicator_paint_sprite(ind);
+    return true;
+}
+
+// Sets up the marker on a spare plane, or in plain memory for software
+// compositing. Returns false (already logged) if there is no indicator.
+static bool indicator_init(struct indicator *ind, int drm, uint32_t crtc_id, uint32_t crtc_index,
+                           const struct target *screen, uint32_t screen_fb) {
+    memset(ind, 0, sizeof(*ind));
+    ind->drm = drm;
+    ind->crtc_id = crtc_id;
+    ind->screen = screen;
+    ind->screen_fb = screen_fb;
+
+    ind->plane_id = find_spare_plane(drm, crtc_index, &ind->plane_type);
+    if (ind->plane_id) {
+        // cursor planes only take buffers of exactly the advertised size
+        uint32_t sw = MARKER_SIZE, sh = MARKER_SIZE;
+        if (ind->plane_type == DRM_PLANE_TYPE_CURSOR) {
+            sw = drm_cap(drm, DRM_CAP_CURSOR_WIDTH,  64);
+            sh = drm_cap(drm, DRM_CAP_CURSOR_HEIGHT, 64);
+        }
+        if (!indicator_plane_buffer(ind, sw, sh)) ind->plane_id = 0;
+    }
+
+    if (ind->plane_id && ind->plane_type == DRM_PLANE_TYPE_OVERLAY) {
+        struct drm_set_client_cap cap = { .capability = DRM_CLIENT_CAP_ATOMIC, .value = 1 };
+        if (ioctl(drm, DRM_IOCTL_SET_CLIENT_CAP, &cap) < 0 ||
+            plane_prop(drm, ind->plane_id, "CRTC_X", &ind->prop_crtc_x) < 0 ||
+            plane_prop(drm, ind->plane_id, "CRTC_Y", &ind->prop_crtc_y) < 0) {
+            logc("init: no atomic KMS, overlay moves will wait for vblank\n");
+            ind->prop_crtc_x = ind->prop_crtc_y = 0;
+        }
+    }
+
+    if (!ind->plane_id) {
+        // compositing only reads the sprite, so plain memory will do
+        uint32_t pitch = MARKER_SIZE * 4;
+        uint8_t *mem = calloc(MARKER_SIZE, pitch);
+        if (!mem) {
+            logc("init: indicator: malloc failed, no progress marker\n");
+            return false;
+        }
+        ind->sprite = (struct target){ mem, MARKER_SIZE, MARKER_SIZE, pitch, DRM_FORMAT_ARGB8888 };
+        ind->marker = MARKER_SIZE;
+        indicator_paint_sprite(ind);
+        if (!indicator_to_software(ind)) return false;
+    }
+
+    int w = screen->width, h = screen->height;
+    ind->track = (struct rect){ w / 4, h * 3 / 4, w * 3 / 4, h * 3 / 4 + ind->marker };
+    if (ind->track.x1 - ind->track.x0 < ind->marker) ind->track.x1 = ind->track.x0 + ind->marker;
+
+    logc("init: indicator on %s, buffer %ux%u\n", !ind->plane_id ? "primary (software)" :
+         ind->plane_type == DRM_PLANE_TYPE_CURSOR ? "cursor plane" : "overlay plane",
+         ind->sprite.width, ind->sprite.height);
+    return true;
+}
+
+static void copy_rect(uint8_t *dst, uint32_t dpitch, const uint8_t *src, uint32_t spitch,
+                      int w, int h) {
+    for (int y = 0; y < h; y++)
+        memcpy(dst + (size_t)y * dpitch, src + (size_t)y * spitch, (size_t)w * 4);
+}
+
+// Software path: restore what was under the old position, save what is
+// under the new one and blend the sprite on top.
+static void indicator_composite(struct indicator *ind, struct rect to) {
+    const struct target *s = ind->screen;
+    struct rect bounds = { 0, 0, s->width, s->height };
+    uint32_t under_pitch = ind->sprite.width * 4;
+    struct drm_clip_rect clips[2];
+    uint32_t nclips = 0;
+
+    struct rect old = rect_intersect(ind->at, bounds);
+    if (!rect_empty(old)) {
+        copy_rect(s->map + (size_t)old.y0 * s->pitch + old.x0 * 4, s->pitch,
+                  (uint8_t *)ind->under, under_pitch, old.x1 - old.x0, old.y1 - old.y0);
+        clips[nclips++] = (struct drm_clip_rect){ old.x0, old.y0, old.x1, old.y1 };
+    }
+
+    struct rect r = rect_intersect(to, bounds);
+    if (!rect_empty(r)) {
+        copy_rect((uint8_t *)ind->under, under_pitch,
+                  s->map + (size_t)r.y0 * s->pitch + r.x0 * 4, s->pitch, r.x1 - r.x0, r.y1 - r.y0);
+        for (int y = r.y0; y < r.y1; y++) {
+            uint32_t *dst = (uint32_t *)(s->map + (size_t)y * s->pitch);
+            const uint32_t *src = (const uint32_t *)(ind->sprite.map + (size_t)(y - to.y0) * ind->sprite.pitch);
+            for (int x = r.x0; x < r.x1; x++) {
+                uint32_t px = src[x - to.x0];
+                if (px >> 24) dst[x] = px & 0x00FFFFFF;
+            }
+        }
+        clips[nclips++] = (struct drm_clip_rect){ r.x0, r.y0, r.x1, r.y1 };
+    }
+    ind->at = r;
+
+    struct drm_mode_fb_dirty_cmd dirty = { .fb_id = ind->screen_fb,
+                                           .num_clips = nclips, .clips_ptr = (uintptr_t)clips };
+    ioctl(ind->drm, DRM_IOCTL_MODE_DIRTYFB, &dirty);
+}
+
+// Moves an already placed overlay without waiting for the next vblank.
+// EBUSY means the previous move hasn't landed yet; this step is dropped.
+static int indicator_move_atomic(struct indicator *ind, struct rect to) {
+    uint32_t objs[]   = { ind->plane_id };
+    uint32_t counts[] = { 2 };
+    uint32_t props[]  = { ind->prop_crtc_x, ind->prop_crtc_y };
+    uint64_t vals[]   = { (uint64_t)(int64_t)to.x0, (uint64_t)(int64_t)to.y0 };
+    struct drm_mode_atomic req = {
+        .flags = DRM_MODE_ATOMIC_NONBLOCK, .count_objs = 1,
+        .objs_ptr = (uintptr_t)objs, .count_props_ptr = (uintptr_t)counts,
+        .props_ptr = (uintptr_t)props, .prop_values_ptr = (uintptr_t)vals,
+    };
+    if (ioctl(ind->drm, DRM_IOCTL_MODE_ATOMIC, &req) == 0) return 0;
+    return errno == EBUSY ? 0 : -1;
+}
+
+// Moves the marker to `permille` (0..1000) along the track.
+static void indicator_set(struct indicator *ind, int permille) {
+    struct rect tr = ind->track;
+    int span = tr.x1 - tr.x0 - ind->marker;
+    int x = tr.x0 + span * permille / 1000;
+    struct rect to = { x, tr.y0, x + (int)ind->sprite.width, tr.y0 + (int)ind->sprite.height };
+    if (ind->off) return;
+
+    if (ind->plane_id) {
+        int ret;
+        if (ind->prop_crtc_x && !rect_empty(ind->at)) {
+            ret = indicator_move_atomic(ind, to);
+        } else {
+            struct drm_mode_set_plane sp = {
+                .plane_id = ind->plane_id, .crtc_id = ind->crtc_id, .fb_id = ind->sprite_fb,
+                .crtc_x = to.x0, .crtc_y = to.y0,
+                .crtc_w = ind->sprite.width, .crtc_h = ind->sprite.height,
+                .src_w = ind->sprite.width << 16, .src_h = ind->sprite.height << 16,
+            };
+            ret = ioctl(ind->drm, DRM_IOCTL_MODE_SETPLANE, &sp);
+        }
+        if (ret == 0) {
+            ind->at = to;
+            return;
+        }
+        logc("init: moving plane %u failed: %m, compositing in software\n", ind->plane_id);
+        if (!indicator_to_software(ind)) return;
+    }
+    indicator_composite(ind, to);
+}
+
+int main(int argc, char **argv) {
+    if (argc > 1 && strcmp(argv[1], "--bench") == 0)
+        return run_bench(argc > 2 ? atoi(argv[2]) : 0);
+
      system("/sbin/modprobe -q simpledrm");
     system("/sbin/modprobe -q vboxvideo");
     system("/sbin/modprobe -q drm_kms_helper");
@@ -94,7 +1086,10 @@ int main(void) {
     logc("init: DRM dumb-buffer demo starting (PID 1)\n");
 
     int drm = open("/dev/dri/card0", O_RDWR | O_CLOEXEC);
-    if (drm < 0) fatal("open /dev/dri/card0 failed: %m");
+    if (drm < 0) {
+        logc("init: open /dev/dri/card0 failed: %m, trying fbdev\n");
+        run_fbdev();
+    }
 
     // 1) Query resources (sizes)
     struct drm_mode_card_res res = {0};
@@ -160,7 +1155,8 @@ int main(void) {
     if (ioctl(drm, DRM_IOCTL_MODE_GETENCODER, &enc) < 0)
         fatal("GETENCODER failed: %m");
 
-    uint32_t crtc_id = pick_crtc_id(&res, &enc);
+    uint32_t crtc_index;
+    uint32_t crtc_id = pick_crtc_id(&res, &enc, &crtc_index);
 
     // 4) Create dumb buffer
     struct drm_mode_create_dumb creq = {0};
@@ -190,44 +1186,7 @@ int main(void) {
     uint8_t *map = mmap(NULL, creq.size, PROT_READ | PROT_WRITE, MAP_SHARED, drm, mreq.offset);
     if (map == MAP_FAILED) fatal("mmap dumb buffer failed: %m");
 
-    // 7) Paint smiley
-    const uint32_t black = 0x00000000;
-    const uint32_t yellow= 0x00FFFF00;
-    const uint32_t eye   = 0x00000000;
-    const uint32_t mouth = 0x00000000;
-
-    // clear
-    for (uint32_t y = 0; y < creq.height; y++) {
-        uint32_t *row = (uint32_t *)(map + y * creq.pitch);
-        for (uint32_t x = 0; x < creq.width; x++) row[x] = black;
-    }
-
-    int cx = creq.width / 2, cy = creq.height / 2;
-    int r  = (creq.height < creq.width ? creq.height : creq.width) / 6;
-
-    for (int y = -r; y <= r; y++) {
-        uint32_t *row = (uint32_t *)(map + (cy + y) * creq.pitch);
-        for (int x = -r; x <= r; x++) {
-            int px = cx + x, py = cy + y;
-            if ((unsigned)px >= creq.width || (unsigned)py >= creq.height) continue;
-
-            int d2 = x*x + y*y;
-            if (d2 <= r*r) row[px] = yellow;
-
-            int ex = r/2, ey = -r/3, er = r/10;
-            int d2L = (x + ex)*(x + ex) + (y + ey)*(y + ey);
-            int d2R = (x - ex)*(x - ex) + (y + ey)*(y + ey);
-            if (d2L <= er*er || d2R <= er*er) row[px] = eye;
-
-            if (y > 0) {
-                int mr = r/2;
-                int d2i = x*x + (y - mr/3)*(y - mr/3);
-                if (d2i >= (mr-2)*(mr-2) && d2i <= (mr+2)*(mr+2)) row[px] = mouth;
-            }
-        }
-    }
-
-    // 8) Program CRTC
+    // 7) Program CRTC; fresh dumb buffers are zero filled, so this shows black
     struct drm_mode_crtc crtc = {0};
     crtc.crtc_id = crtc_id;
     crtc.fb_id   = fb.fb_id;
@@ -238,9 +1197,33 @@ int main(void) {
 
     if (ioctl(drm, DRM_IOCTL_MODE_SETCRTC, &crtc) < 0)
         fatal("SETCRTC failed: %m");
+    double t_modeset = now_ms();
+
+    // 8) Paint splash (or smiley) directly into the scanout buffer
+    struct target target = { map, creq.width, creq.height, creq.pitch, DRM_FORMAT_XRGB8888 };
+    paint_boot_screen(&target, false);
+
+    // drivers with a shadow buffer (virtio-gpu, vboxvideo, ...) need a flush
+    struct drm_mode_fb_dirty_cmd dirty = { .fb_id = fb.fb_id };
+    ioctl(drm, DRM_IOCTL_MODE_DIRTYFB, &dirty);
 
-    logc("init: smiley shown %ux%u pitch=%u fb=%u crtc=%u conn=%u\n",
-         creq.width, creq.height, creq.pitch, fb.fb_id, crtc_id, connector_id);
+    logc("init: splash visible %.2f ms after mode set, %ux%u pitch=%u fb=%u crtc=%u conn=%u\n",
+         now_ms() - t_modeset, creq.width, creq.height, creq.pitch, fb.fb_id, crtc_id, connector_id);
+
+    // 9) Boot progress on its own plane (or composited when there is none)
+    struct indicator ind;
+    if (indicator_init(&ind, drm, crtc_id, crtc_index, &target, fb.fb_id)) {
+        double worst = 0, sum = 0;
+        for (int p = 0; p <= 1000; p += 10) {
+            double t0 = now_ms();
+            indicator_set(&ind, p);
+            double dt = now_ms() - t0;
+            sum += dt;
+            if (dt > worst) worst = dt;
+            usleep(20000);
+        }
+        logc("init: progress updates avg %.3f ms, worst %.3f ms\n", sum / 101, worst);
+    }
 
     signal(SIGINT, SIG_IGN);
     for (;;) pause();
@@ -20,7 +20,7 @@ BASENAME=$(basename "$SOURCE_FILE" .c)
 
 # Compile the C program
 echo "Compiling $SOURCE_FILE..."
-gcc -static -O2 -Wall -o "$BASENAME" "$SOURCE_FILE"
+gcc -static -O2 -Wall -pthread -o "$BASENAME" "$SOURCE_FILE"
 
 # Check if compilation was successful
 if [ $? -eq 0 ]; then